@@ -12,6 +12,9 @@
 #include <algorithm>
 #include <climits>
 #include <queue>
+#include <chrono>
+#include <type_traits>
+#include <utility>
 
 // define namespace and alias
 namespace fs = std::filesystem;
@@ -27,6 +30,9 @@ namespace fs = std::filesystem;
 #define mainDir2 "tempFolder"
 std::string mainDir = mainDir1;
 
+// Number of times each query is repeated per backend when benchmarking
+#define benchmarkRuns 25
+
 // Enum to store the type of search query
 enum searchType { defaultSearch, addSearch, subSearch, sentenceSearch, sentenceSubSearch, invalidSearch };
 
@@ -44,7 +50,7 @@ class wordInDocument{
     	void setContent(const std::string& cont) { content = cont; }
         std::string getContent() const { return content; }
         void addPosition(int pos) { positions.push_back(pos); }
-    	std::string getDocumentName() const { return documentName; }
+    	const std::string& getDocumentName() const { return documentName; }
     	const std::vector<int>& getPositions() const { return positions; }
     	int getFrequency() const { return positions.size(); }
         bool appearsInDocument(const std::string& docName) const { return documentName == docName; }
@@ -53,264 +59,50 @@ class wordInDocument{
         ~wordInDocument() = default;
 };
 
-class searchEngineUnordered {
+// Read-only view over postings stored contiguously in a vector, borrowed from the index backend without copying.
+// Both backends below keep their postings in vectors, so both use it as their view.
+class postingsView {
     private:
-        std::unordered_map<std::string, std::vector<wordInDocument>> filesMap; 
-        
-        void queryType(const std::string& query, searchType& type) {
-            type = invalidSearch;
-            std::string tempQuery = query;
-            std::transform(tempQuery.begin(), tempQuery.end(), tempQuery.begin(), ::tolower);
-            if (tempQuery.find(addSign) != std::string::npos) type = addSearch;
-            else if (tempQuery.find(sentenceSign) != std::string::npos) {
-                if (tempQuery.find(subSign) != std::string::npos) type = sentenceSubSearch;
-                else type = sentenceSearch;
-            }
-            else if (tempQuery.find(subSign) != std::string::npos) type = subSearch;
-            else type = defaultSearch;
-        }
-        
-        std::vector<std::pair<std::string, int>> searchDefault(const std::string& query) {
-            std::istringstream iss(query);
-            std::string word;
-            std::unordered_map<std::string, int> documentScores; 
-            std::unordered_map<std::string, std::unordered_set<std::string>> documentWordMap;
-            std::unordered_map<std::string, int> wordCount;
-            std::vector<std::string> words;
-            while (iss >> word) {
-                std::transform(word.begin(), word.end(), word.begin(), ::tolower);
-                words.push_back(word);
-                wordCount[word]++;
-            }
-            for (const auto& queryWord : words) {
-                if (filesMap.find(queryWord) != filesMap.end()) {
-                    for (const auto& doc : filesMap[queryWord]) {
-                        documentScores[doc.getDocumentName()] += doc.getFrequency();
-                        documentWordMap[doc.getDocumentName()].insert(queryWord);
-                    }
-                }
-            }
-            std::vector<std::pair<std::string, int>> results;
-            for (const auto& [docName, score] : documentScores) results.push_back({docName, score});
-            std::sort(results.begin(), results.end(), [&](const auto& a, const auto& b) {
-                size_t wordsA = documentWordMap[a.first].size();
-                size_t wordsB = documentWordMap[b.first].size();
-                if (wordsA != wordsB) return wordsA > wordsB;
-                return a.second > b.second;
-            });
-            return results;
-        }
-
-        std::vector<std::pair<std::string, int>> searchAdd(const std::string& query) {
-            std::vector<std::pair<std::string, int>> results;
-            std::istringstream iss(query);
-            std::string word;
-            std::vector<std::string> words;
-            while (std::getline(iss, word, addSign)) {
-                std::transform(word.begin(), word.end(), word.begin(), ::tolower);
-                words.push_back(word);
-            }
-            std::unordered_map<std::string, std::vector<int>> documentOccurrences;
-            for (const auto& word : words) {
-                if (filesMap.find(word) != filesMap.end()) {
-                    for (const auto& doc : filesMap[word]) {
-                        const std::string& docName = doc.getDocumentName();
-                        if (documentOccurrences.find(docName) == documentOccurrences.end()) documentOccurrences[docName] = std::vector<int>(words.size(), 0);
-                        auto it = std::find(words.begin(), words.end(), word);
-                        int wordIndex = std::distance(words.begin(), it);
-                        documentOccurrences[docName][wordIndex] = doc.getFrequency();
-                    }
-                }
-            }
-            for (const auto& [docName, freqs] : documentOccurrences) {
-                bool containsAllWords = true;
-                int minOccurrences = INT_MAX;
-                for (const auto& word : words) {
-                    bool wordFoundInDoc = false;
-                    int wordFrequency = 0;
-                    for (const auto& doc : filesMap[word]) {
-                        if (doc.getDocumentName() == docName) {
-                            wordFoundInDoc = true;
-                            wordFrequency = doc.getFrequency();
-                            break;
-                        }
-                    }
-                    if (!wordFoundInDoc) { containsAllWords = false; break; }
-                    minOccurrences = std::min(minOccurrences, wordFrequency);
-                }
-                if (containsAllWords) results.push_back({docName, minOccurrences});
-            }
-            std::sort(results.begin(), results.end(), [](const std::pair<std::string, int>& a, const std::pair<std::string, int>& b) { return a.second > b.second; });
-            return results;
-        }
+        const wordInDocument* first;
+        const wordInDocument* last;
+    public:
+        using cursor = const wordInDocument*;
+        postingsView() : first(nullptr), last(nullptr) {}
+        explicit postingsView(const std::vector<wordInDocument>& postings) : first(postings.data()), last(postings.data() + postings.size()) {}
+        cursor begin() const { return first; }
+        cursor end() const { return last; }
+        size_t size() const { return last - first; }
+        bool empty() const { return first == last; }
+};
 
-        std::vector<std::pair<std::string, int>> searchSub(const std::string& query) {
-            std::vector<std::pair<std::string, int>> results;
-            std::istringstream iss(query);
-            std::string word;
-            std::vector<std::string> words;
-            while (std::getline(iss, word, subSign)) {
-                std::transform(word.begin(), word.end(), word.begin(), ::tolower);  // Convert to lowercase
-                words.push_back(word);
-            }
-            std::string word1 = words[0]; 
-            std::vector<std::string> excludeWords(words.begin() + 1, words.end());
-            if (filesMap.find(word1) != filesMap.end()) {
-                for (const auto& doc : filesMap[word1]) {
-                    const std::string& docName = doc.getDocumentName();
-                    bool containsAnyExcludeWord = false;
-                    for (const auto& excludeWord : excludeWords) {
-                        if (filesMap.find(excludeWord) != filesMap.end()) {
-                            for (const auto& doc2 : filesMap[excludeWord]) if (doc2.getDocumentName() == docName) { containsAnyExcludeWord = true; break; }
-                        }
-                        if (containsAnyExcludeWord) break;
-                    }
-                    if (!containsAnyExcludeWord) results.push_back({docName, doc.getFrequency()});
-                }
-            }
-            std::sort(results.begin(), results.end(), [](const std::pair<std::string, int>& a, const std::pair<std::string, int>& b) { return a.second > b.second; });
-            return results;
-        }
+// Index backends plug into searchCore by providing:
+//   view                                                   // type with begin(), end() and size(), its cursors dereference to const wordInDocument&
+//   void insert(const std::string& word, const std::string& docName, const std::string& docContent, int pos);
+//   view lookup(const std::string& word) const;            // empty view if the word is not indexed
+//   size_t cardinality(const std::string& word) const;     // number of documents containing the word
+// Every word keeps exactly one posting per document, holding all of its positions in that document.
+// Files are inserted in sorted order, so appending keeps each word's postings sorted by document name.
+// searchCore and searchEngineOver check these signatures when instantiated and call them directly, so there is no virtual dispatch.
 
-        std::vector<std::pair<std::string, int>> searchSentence(const std::string& query) {
-            std::vector<std::pair<std::string, int>> results;
-            std::string sentence = query.substr(1, query.size() - 2);
-            std::istringstream iss(sentence);
-            std::string word;
-            std::vector<std::string> words;
-            while (iss >> word) {
-                std::transform(word.begin(), word.end(), word.begin(), ::tolower);
-                words.push_back(word);
-            }
-            std::unordered_map<std::string, std::vector<int>> documentOccurrences;
-            for (const auto& word : words) {
-                if (filesMap.find(word) != filesMap.end()) {
-                    for (const auto& doc : filesMap[word]) {
-                        const std::string& docName = doc.getDocumentName();
-                        if (documentOccurrences.find(docName) == documentOccurrences.end()) documentOccurrences[docName] = std::vector<int>(words.size(), 0);
-                        auto it = std::find(words.begin(), words.end(), word);
-                        int wordIndex = std::distance(words.begin(), it);
-                        documentOccurrences[docName][wordIndex] = doc.getFrequency();
-                    }
-                }
-            }
-            for (const auto& [docName, freqs] : documentOccurrences) {
-                bool containsAllWords = true;
-                int minOccurrences = INT_MAX;
-                for (const auto& word : words) {
-                    bool wordFoundInDoc = false;
-                    int wordFrequency = 0;
-                    for (const auto& doc : filesMap[word]) {
-                        if (doc.getDocumentName() == docName) {
-                            wordFoundInDoc = true;
-                            wordFrequency = doc.getFrequency();
-                            break;
-                        }
-                    }
-                    if (!wordFoundInDoc) { containsAllWords = false; break; }
-                    minOccurrences = std::min(minOccurrences, wordFrequency);
-                }
-                if (containsAllWords) results.push_back({docName, minOccurrences});
-            }
-            std::sort(results.begin(), results.end(), [](const std::pair<std::string, int>& a, const std::pair<std::string, int>& b) { return a.second > b.second; });
-            return results;
-        }
+class unorderedIndex {
+    private:
+        std::unordered_map<std::string, std::vector<wordInDocument>> filesMap;
+    public:
+        using view = postingsView;
 
-        std::vector<std::pair<std::string, int>> searchSentenceSub(const std::string& query) {
-            std::vector<std::pair<std::string, int>> finalResults, results;
-            std::istringstream queryStream(query);
-            std::string sentence;
-            std::queue<std::string> sentences;
-            while (std::getline(queryStream, sentence, '-')) {
-                sentence.erase(0, sentence.find_first_not_of(" \t"));
-                sentence.erase(sentence.find_last_not_of(" \t") + 1);
-                sentences.push(sentence);
-            }
-            bool haveToCheckFirst = true;
-            while(!sentences.empty()){
-                if (haveToCheckFirst){
-                    haveToCheckFirst = false;
-                    std::string firstSentence = sentences.front();
-                    sentences.pop();
-                    finalResults = searchSentence(firstSentence);
-                    results = finalResults;
-                } else {
-                    std::string sentence = sentences.front();
-                    sentences.pop();
-                    std::vector<std::pair<std::string, int>> resultsFromOtherSentence = searchSentence(sentence);
-                    for (const auto& result : results){
-                        if (std::find(resultsFromOtherSentence.begin(), resultsFromOtherSentence.end(), result) == resultsFromOtherSentence.end()){
-                            results.erase(std::remove(results.begin(), results.end(), result), results.end());
-                        }
-                    }
-                }
-            }
-            for (const auto& result : results) {
-                if (std::find(finalResults.begin(), finalResults.end(), result) != finalResults.end()) 
-                    finalResults.erase(std::remove(finalResults.begin(), finalResults.end(), result), finalResults.end()); 
-            }
-            return finalResults;
-        }
-        
-        void indexFiles() {
-            std::vector<std::string> files;
-            for (const auto& entry : fs::directory_iterator(mainDir)) files.push_back(entry.path().string());
-            for (const auto& file : files) {
-                std::ifstream fin(file);
-                std::string line, content;
-                int pos = 0;
-                while (std::getline(fin, line)) {
-                    content += line + " ";
-                    std::istringstream iss(line);
-                    std::string word;
-                    while (iss >> word) {
-                        std::transform(word.begin(), word.end(), word.begin(), ::tolower);
-                        if (filesMap.find(word) == filesMap.end()) 
-                            filesMap[word].push_back(wordInDocument(file, content, pos));
-                        else {
-                            if (std::find(filesMap[word].begin(), filesMap[word].end(), wordInDocument(file, content)) == filesMap[word].end()) 
-                                filesMap[word].push_back(wordInDocument(file, content, pos));
-                            else for (auto& wordDoc : filesMap[word]) if (wordDoc.appearsInDocument(file)) wordDoc.addPosition(pos);
-                        }
-                        pos++;
-                    }
-                }
-            }
+        void insert(const std::string& word, const std::string& docName, const std::string& docContent, int pos) {
+            std::vector<wordInDocument>& postings = filesMap[word];
+            // files are indexed one after another, so the current document can only be the last posting
+            if (!postings.empty() && postings.back().appearsInDocument(docName)) postings.back().addPosition(pos);
+            else postings.push_back(wordInDocument(docName, docContent, pos));
         }
 
-        void search(const std::string& query) {
-            searchType type;
-            queryType(query, type);
-            std::string types[] = {"defaultSearch", "addSearch", "subSearch", "sentenceSearch","sentenceSubSearch", "invalidSearch"};
-            std::cout << "Type: " << types[type] << std::endl;
-            std::vector<std::pair<std::string, int>> results;
-            switch (type) {
-                case defaultSearch: results = searchDefault(query); break;
-                case addSearch: results = searchAdd(query); break;
-                case subSearch: results = searchSub(query); break;
-                case sentenceSearch: results = searchSentence(query); break;
-                case sentenceSubSearch: results = searchSentenceSub(query); break;
-                case invalidSearch: { std::cout << "Invalid search query\n"; return; } break;
-            }
-        
-            if (results.empty()) std::cout << "No results found\n";
-            else for (const auto& result : results) { std::cout << result.first << "   " << result.second << std::endl; }
+        view lookup(const std::string& word) const {
+            auto it = filesMap.find(word);
+            return it == filesMap.end() ? view() : view(it->second);
         }
 
-    public:
-        searchEngineUnordered() { this->indexFiles(); }
-        
-        void engine() {
-            while(true){
-                std::string query;
-                std::cout << "Enter query: ";
-                std::getline(std::cin, query);
-                if (query == "exit") break;
-                this->search(query);
-            }
-        }
-        
-        ~searchEngineUnordered() = default;
+        size_t cardinality(const std::string& word) const { return lookup(word).size(); }
 };
 
 struct trieNode {
@@ -332,83 +124,124 @@ class trie{
         }
 
     public:
+        using view = postingsView;
+
         trie() { root = new trieNode(); }
 
         void insert(const std::string& word, const std::string& docName, const std::string& docContent, int pos) {
-            wordInDocument wordDoc(docName, docContent, pos);
             trieNode* current = root;
             for (const auto& letter : word) {
                 if (current->children.find(letter) == current->children.end()) current->children[letter] = new trieNode();
                 current = current->children[letter];
             }
-            current->occurrences.push_back(wordDoc);
+            // files are indexed one after another, so the current document can only be the last posting
+            std::vector<wordInDocument>& postings = current->occurrences;
+            if (!postings.empty() && postings.back().appearsInDocument(docName)) postings.back().addPosition(pos);
+            else postings.push_back(wordInDocument(docName, docContent, pos));
             current->isEndOfWord = true;
         }
 
-        std::vector<wordInDocument> search(const std::string& word) {
-            trieNode* current = root;
+        view lookup(const std::string& word) const {
+            const trieNode* current = root;
             for (const auto& letter : word) {
-                if (current->children.find(letter) == current->children.end()) return {};
-                current = current->children[letter];
+                auto it = current->children.find(letter);
+                if (it == current->children.end()) return view();
+                current = it->second;
             }
-            return current->isEndOfWord ? current->occurrences : std::vector<wordInDocument>();
+            return current->isEndOfWord ? view(current->occurrences) : view();
         }
 
+        size_t cardinality(const std::string& word) const { return lookup(word).size(); }
+
         ~trie() { this->clear(root); }
 };
 
-class searchEngineTries{
+// Compile-time checks of the index backend contract above
+template <typename backend, typename = void>
+struct hasPostingsView : std::false_type {};
+template <typename backend>
+struct hasPostingsView<backend, std::enable_if_t<
+    std::is_convertible<decltype(*std::declval<const typename backend::view&>().begin()), const wordInDocument&>::value &&
+    std::is_convertible<decltype(std::declval<const typename backend::view&>().begin() != std::declval<const typename backend::view&>().end()), bool>::value &&
+    std::is_same<decltype(std::declval<const typename backend::view&>().size()), size_t>::value>> : std::true_type {};
+
+template <typename backend, typename = void>
+struct hasPostingsLookup : std::false_type {};
+template <typename backend>
+struct hasPostingsLookup<backend, std::enable_if_t<std::is_same<decltype(std::declval<const backend&>().lookup(std::declval<const std::string&>())), typename backend::view>::value>> : std::true_type {};
+
+template <typename backend, typename = void>
+struct hasCardinality : std::false_type {};
+template <typename backend>
+struct hasCardinality<backend, std::enable_if_t<std::is_same<decltype(std::declval<const backend&>().cardinality(std::declval<const std::string&>())), size_t>::value>> : std::true_type {};
+
+template <typename backend, typename = void>
+struct hasPostingsInsert : std::false_type {};
+template <typename backend>
+struct hasPostingsInsert<backend, std::void_t<decltype(std::declval<backend&>().insert(std::declval<const std::string&>(), std::declval<const std::string&>(), std::declval<const std::string&>(), 0))>> : std::true_type {};
+
+// Query execution shared by every index backend
+template <typename indexBackend>
+class searchCore {
+    static_assert(hasPostingsView<indexBackend>::value, "index backend must provide a 'view' type with begin(), end() and size() whose cursors dereference to const wordInDocument&");
+    static_assert(hasPostingsLookup<indexBackend>::value, "index backend must provide 'view lookup(const std::string&) const'");
+    static_assert(hasCardinality<indexBackend>::value, "index backend must provide 'size_t cardinality(const std::string&) const'");
+
     private:
-        trie trieObj;
+        const indexBackend& index;
 
-        void indexFiles() {
-            std::vector<std::string> files;
-            for (const auto& entry : fs::directory_iterator(mainDir)) files.push_back(entry.path().string());
-            for (const auto& file : files) {
-                std::ifstream fin(file);
-                std::string line, content;
-                int pos = 0;
-                while (std::getline(fin, line)) {
-                    content += line + " ";
-                    std::istringstream iss(line);
-                    std::string word;
-                    while (iss >> word) {
-                        std::transform(word.begin(), word.end(), word.begin(), ::tolower);
-                        trieObj.insert(word, file, content, pos);
-                        pos++;
-                    }
-                }
-            }
+        static void sortByScore(std::vector<std::pair<std::string, int>>& results) {
+            std::sort(results.begin(), results.end(), [](const std::pair<std::string, int>& a, const std::pair<std::string, int>& b) { return a.second > b.second; });
         }
 
-        void queryType(const std::string& query, searchType& type) {
-            type = invalidSearch;
-            std::string tempQuery = query;
-            std::transform(tempQuery.begin(), tempQuery.end(), tempQuery.begin(), ::tolower);
-            if (tempQuery.find(addSign) != std::string::npos) type = addSearch;
-            else if (tempQuery.find(sentenceSign) != std::string::npos) {
-                if (tempQuery.find(subSign) != std::string::npos) type = sentenceSubSearch;
-                else type = sentenceSearch;
+        // Documents containing every word, scored by the lowest frequency among them.
+        // Postings are sorted by document name, so the rarest word drives the scan and the other cursors only move forward.
+        std::vector<std::pair<std::string, int>> searchAllWords(const std::vector<std::string>& words) const {
+            using view = typename indexBackend::view;
+            using cursor = decltype(std::declval<const view&>().begin());
+            std::vector<std::pair<std::string, int>> results;
+            std::vector<std::string> uniqueWords;
+            std::vector<view> views;
+            for (const auto& word : words) {
+                if (std::find(uniqueWords.begin(), uniqueWords.end(), word) != uniqueWords.end()) continue;
+                uniqueWords.push_back(word);
+                views.push_back(index.lookup(word));
+                if (views.back().size() == 0) return results;
+            }
+            if (views.empty()) return results;
+            std::sort(views.begin(), views.end(), [](const view& a, const view& b) { return a.size() < b.size(); });
+            std::vector<cursor> cursors, ends;
+            for (size_t i = 1; i < views.size(); i++) { cursors.push_back(views[i].begin()); ends.push_back(views[i].end()); }
+            for (const auto& doc : views.front()) {
+                const std::string& docName = doc.getDocumentName();
+                bool containsAllWords = true, exhausted = false;
+                int minOccurrences = doc.getFrequency();
+                for (size_t i = 0; i < cursors.size(); i++) {
+                    while (cursors[i] != ends[i] && (*cursors[i]).getDocumentName() < docName) ++cursors[i];
+                    if (cursors[i] == ends[i]) { containsAllWords = false; exhausted = true; break; }
+                    const wordInDocument& other = *cursors[i];
+                    if (other.getDocumentName() != docName) { containsAllWords = false; break; }
+                    minOccurrences = std::min(minOccurrences, other.getFrequency());
+                }
+                if (containsAllWords) results.push_back({docName, minOccurrences});
+                if (exhausted) break;
             }
-            else if (tempQuery.find(subSign) != std::string::npos) type = subSearch;
-            else type = defaultSearch;
+            sortByScore(results);
+            return results;
         }
 
-        std::vector<std::pair<std::string, int>> searchDefault(const std::string& query) {
+        std::vector<std::pair<std::string, int>> searchDefault(const std::string& query) const {
             std::istringstream iss(query);
             std::string word;
-            std::unordered_map<std::string, int> documentScores; 
+            std::unordered_map<std::string, int> documentScores;
             std::unordered_map<std::string, std::unordered_set<std::string>> documentWordMap;
-            std::unordered_map<std::string, int> wordCount;
             std::vector<std::string> words;
             while (iss >> word) {
                 std::transform(word.begin(), word.end(), word.begin(), ::tolower);
                 words.push_back(word);
-                wordCount[word]++;
             }
             for (const auto& queryWord : words) {
-                std::vector<wordInDocument> occurrences = trieObj.search(queryWord);
-                for (const auto& doc : occurrences) {
+                for (const auto& doc : index.lookup(queryWord)) {
                     documentScores[doc.getDocumentName()] += doc.getFrequency();
                     documentWordMap[doc.getDocumentName()].insert(queryWord);
                 }
@@ -424,8 +257,7 @@ class searchEngineTries{
             return results;
         }
 
-        std::vector<std::pair<std::string, int>> searchAdd(const std::string& query) {
-            std::vector<std::pair<std::string, int>> results;
+        std::vector<std::pair<std::string, int>> searchAdd(const std::string& query) const {
             std::istringstream iss(query);
             std::string word;
             std::vector<std::string> words;
@@ -433,41 +265,10 @@ class searchEngineTries{
                 std::transform(word.begin(), word.end(), word.begin(), ::tolower);
                 words.push_back(word);
             }
-            std::unordered_map<std::string, std::vector<int>> documentOccurrences;
-            for (const auto& word : words) {
-                std::vector<wordInDocument> occurrences = trieObj.search(word);
-                for (const auto& doc : occurrences) {
-                    const std::string& docName = doc.getDocumentName();
-                    if (documentOccurrences.find(docName) == documentOccurrences.end()) documentOccurrences[docName] = std::vector<int>(words.size(), 0);
-                    auto it = std::find(words.begin(), words.end(), word);
-                    int wordIndex = std::distance(words.begin(), it);
-                    documentOccurrences[docName][wordIndex] = doc.getFrequency();
-                }
-            }
-            for (const auto& [docName, freqs] : documentOccurrences) {
-                bool containsAllWords = true;
-                int minOccurrences = INT_MAX;
-                for (const auto& word : words) {
-                    std::vector<wordInDocument> occurrences = trieObj.search(word);
-                    bool wordFoundInDoc = false;
-                    int wordFrequency = 0;
-                    for (const auto& doc : occurrences) {
-                        if (doc.getDocumentName() == docName) {
-                            wordFoundInDoc = true;
-                            wordFrequency = doc.getFrequency();
-                            break;
-                        }
-                    }
-                    if (!wordFoundInDoc) { containsAllWords = false; break; }
-                    minOccurrences = std::min(minOccurrences, wordFrequency);
-                }
-                if (containsAllWords) results.push_back({docName, minOccurrences});
-            }
-            std::sort(results.begin(), results.end(), [](const std::pair<std::string, int>& a, const std::pair<std::string, int>& b) { return a.second > b.second; });
-            return results;
+            return searchAllWords(words);
         }
 
-        std::vector<std::pair<std::string, int>> searchSub(const std::string& query) {
+        std::vector<std::pair<std::string, int>> searchSub(const std::string& query) const {
             std::vector<std::pair<std::string, int>> results;
             std::istringstream iss(query);
             std::string word;
@@ -476,26 +277,18 @@ class searchEngineTries{
                 std::transform(word.begin(), word.end(), word.begin(), ::tolower);  // Convert to lowercase
                 words.push_back(word);
             }
-            std::string word1 = words[0]; 
-            std::vector<std::string> excludeWords(words.begin() + 1, words.end());
-            std::vector<wordInDocument> occurrences = trieObj.search(word1);
-            for (const auto& doc : occurrences) {
-                const std::string& docName = doc.getDocumentName();
-                bool containsAnyExcludeWord = false;
-                for (const auto& excludeWord : excludeWords) {
-                    std::vector<wordInDocument> excludeOccurrences = trieObj.search(excludeWord);
-                    bool excludeWordFound = false;
-                    for (const auto& doc2 : excludeOccurrences) if (doc2.getDocumentName() == docName) { excludeWordFound = true; break; }
-                    if (excludeWordFound) { containsAnyExcludeWord = true; break; }
-                }
-                if (!containsAnyExcludeWord) results.push_back({docName, doc.getFrequency()});
+            std::string word1 = words[0];
+            std::unordered_set<std::string> excludedDocuments;
+            for (auto it = words.begin() + 1; it != words.end(); ++it)
+                for (const auto& doc : index.lookup(*it)) excludedDocuments.insert(doc.getDocumentName());
+            for (const auto& doc : index.lookup(word1)) {
+                if (excludedDocuments.find(doc.getDocumentName()) == excludedDocuments.end()) results.push_back({doc.getDocumentName(), doc.getFrequency()});
             }
-            std::sort(results.begin(), results.end(), [](const std::pair<std::string, int>& a, const std::pair<std::string, int>& b) { return a.second > b.second; });
+            sortByScore(results);
             return results;
         }
 
-        std::vector<std::pair<std::string, int>> searchSentence(const std::string& query) {
-            std::vector<std::pair<std::string, int>> results;
+        std::vector<std::pair<std::string, int>> searchSentence(const std::string& query) const {
             std::string sentence = query.substr(1, query.size() - 2);
             std::istringstream iss(sentence);
             std::string word;
@@ -504,147 +297,216 @@ class searchEngineTries{
                 std::transform(word.begin(), word.end(), word.begin(), ::tolower);
                 words.push_back(word);
             }
-            std::unordered_map<std::string, std::vector<int>> documentOccurrences;
-            for (const auto& word : words) {
-                std::vector<wordInDocument> occurrences = trieObj.search(word);
-                for (const auto& doc : occurrences) {
-                    const std::string& docName = doc.getDocumentName();
-                    if (documentOccurrences.find(docName) == documentOccurrences.end()) documentOccurrences[docName] = std::vector<int>(words.size(), 0);
-                    auto it = std::find(words.begin(), words.end(), word);
-                    int wordIndex = std::distance(words.begin(), it);
-                    documentOccurrences[docName][wordIndex] = doc.getFrequency();
-                }
-            }
-            for (const auto& [docName, freqs] : documentOccurrences) {
-                bool containsAllWords = true;
-                int minOccurrences = INT_MAX;
-                for (const auto& word : words) {
-                    std::vector<wordInDocument> occurrences = trieObj.search(word);
-                    bool wordFoundInDoc = false;
-                    int wordFrequency = 0;
-                    for (const auto& doc : occurrences) {
-                        if (doc.getDocumentName() == docName) {
-                            wordFoundInDoc = true;
-                            wordFrequency = doc.getFrequency();
-                            break;
-                        }
-                    }
-                    if (!wordFoundInDoc) { containsAllWords = false; break; }
-                    minOccurrences = std::min(minOccurrences, wordFrequency);
-                }
-                if (containsAllWords) results.push_back({docName, minOccurrences});
-            }
-            std::sort(results.begin(), results.end(), [](const std::pair<std::string, int>& a, const std::pair<std::string, int>& b) { return a.second > b.second; });
-            return results;
+            return searchAllWords(words);
         }
 
-        std::vector<std::pair<std::string, int>> searchSentenceSub(const std::string& query) {
-            std::vector<std::pair<std::string, int>> finalResults, results;
+        std::vector<std::pair<std::string, int>> searchSentenceSub(const std::string& query) const {
+            std::vector<std::pair<std::string, int>> results;
             std::istringstream queryStream(query);
             std::string sentence;
             std::queue<std::string> sentences;
-            while (std::getline(queryStream, sentence, '-')) {
+            while (std::getline(queryStream, sentence, subSign)) {
                 sentence.erase(0, sentence.find_first_not_of(" \t"));
                 sentence.erase(sentence.find_last_not_of(" \t") + 1);
-                sentences.push(sentence);
+                if (!sentence.empty()) sentences.push(sentence);
             }
-            bool haveToCheckFirst = true;
+            if (sentences.empty()) return results;
+            results = searchSentence(sentences.front());
+            sentences.pop();
+            std::unordered_set<std::string> excludedDocuments;
             while(!sentences.empty()){
-                if (haveToCheckFirst){
-                    haveToCheckFirst = false;
-                    std::string firstSentence = sentences.front();
-                    sentences.pop();
-                    finalResults = searchSentence(firstSentence);
-                    results = finalResults;
-                } else {
-                    std::string sentence = sentences.front();
-                    sentences.pop();
-                    std::vector<std::pair<std::string, int>> resultsFromOtherSentence = searchSentence(sentence);
-                    for (const auto& result : results){
-                        if (std::find(resultsFromOtherSentence.begin(), resultsFromOtherSentence.end(), result) == resultsFromOtherSentence.end()){
-                            results.erase(std::remove(results.begin(), results.end(), result), results.end());
-                        }
+                for (const auto& result : searchSentence(sentences.front())) excludedDocuments.insert(result.first);
+                sentences.pop();
+            }
+            results.erase(std::remove_if(results.begin(), results.end(), [&](const std::pair<std::string, int>& result) {
+                return excludedDocuments.find(result.first) != excludedDocuments.end();
+            }), results.end());
+            return results;
+        }
+
+    public:
+        explicit searchCore(const indexBackend& idx) : index(idx) {}
+
+        void queryType(const std::string& query, searchType& type) const {
+            type = invalidSearch;
+            std::string tempQuery = query;
+            std::transform(tempQuery.begin(), tempQuery.end(), tempQuery.begin(), ::tolower);
+            if (tempQuery.find(addSign) != std::string::npos) type = addSearch;
+            else if (tempQuery.find(sentenceSign) != std::string::npos) {
+                if (tempQuery.find(subSign) != std::string::npos) type = sentenceSubSearch;
+                else type = sentenceSearch;
+            }
+            else if (tempQuery.find(subSign) != std::string::npos) type = subSearch;
+            else type = defaultSearch;
+        }
+
+        std::vector<std::pair<std::string, int>> run(const std::string& query, searchType type) const {
+            switch (type) {
+                case defaultSearch: return searchDefault(query);
+                case addSearch: return searchAdd(query);
+                case subSearch: return searchSub(query);
+                case sentenceSearch: return searchSentence(query);
+                case sentenceSubSearch: return searchSentenceSub(query);
+                case invalidSearch: break;
+            }
+            return {};
+        }
+
+        ~searchCore() = default;
+};
+
+template <typename indexBackend>
+class searchEngineOver {
+    static_assert(hasPostingsInsert<indexBackend>::value, "index backend must provide 'void insert(const std::string& word, const std::string& docName, const std::string& docContent, int pos)'");
+
+    private:
+        indexBackend index;
+
+        void indexFiles() {
+            std::vector<std::string> files;
+            for (const auto& entry : fs::directory_iterator(mainDir)) files.push_back(entry.path().string());
+            std::sort(files.begin(), files.end());
+            for (const auto& file : files) {
+                std::ifstream fin(file);
+                std::string line, content;
+                int pos = 0;
+                while (std::getline(fin, line)) {
+                    content += line + " ";
+                    std::istringstream iss(line);
+                    std::string word;
+                    while (iss >> word) {
+                        std::transform(word.begin(), word.end(), word.begin(), ::tolower);
+                        index.insert(word, file, content, pos);
+                        pos++;
                     }
                 }
             }
-            for (const auto& result : results) {
-                if (std::find(finalResults.begin(), finalResults.end(), result) != finalResults.end()) 
-                    finalResults.erase(std::remove(finalResults.begin(), finalResults.end(), result), finalResults.end()); 
-            }
-            return finalResults;
         }
-        
+
         void search(const std::string& query) {
             searchType type;
-            queryType(query, type);
+            searchCore<indexBackend>(index).queryType(query, type);
             std::string types[] = {"defaultSearch", "addSearch", "subSearch", "sentenceSearch","sentenceSubSearch", "invalidSearch"};
             std::cout << "Type: " << types[type] << std::endl;
-            std::vector<std::pair<std::string, int>> results;
-            switch (type) {
-                case defaultSearch: results = searchDefault(query); break;
-                case addSearch: results = searchAdd(query); break;
-                case subSearch: results = searchSub(query); break;
-                case sentenceSearch: results = searchSentence(query); break;
-                case sentenceSubSearch: results = searchSentenceSub(query); break;
-                case invalidSearch: { std::cout << "Invalid search query\n"; return; } break;
-            }
-        
+            if (type == invalidSearch) { std::cout << "Invalid search query\n"; return; }
+            std::vector<std::pair<std::string, int>> results = this->execute(query);
+
             if (results.empty()) std::cout << "No results found\n";
             else for (const auto& result : results) { std::cout << result.first << "   " << result.second << std::endl; }
         }
 
     public:
-        searchEngineTries() { this->indexFiles(); }
+        searchEngineOver() { this->indexFiles(); }
+
+        std::vector<std::pair<std::string, int>> execute(const std::string& query) const {
+            searchCore<indexBackend> core(index);
+            searchType type;
+            core.queryType(query, type);
+            return core.run(query, type);
+        }
 
         void engine() {
             while(true){
                 std::string query;
                 std::cout << "Enter query: ";
-                std::getline(std::cin, query);
-                if (query == "exit") break;
+                if (!std::getline(std::cin, query) || query == "exit") break;
                 this->search(query);
             }
         }
 
-        ~searchEngineTries() = default;
+        ~searchEngineOver() = default;
 };
 
+using searchEngineUnordered = searchEngineOver<unorderedIndex>;
+using searchEngineTries = searchEngineOver<trie>;
+
+// Runs the query on the engine, stores its results and returns the time taken in microseconds
+template <typename engineType>
+double timeQuery(const engineType& engine, const std::string& query, std::vector<std::pair<std::string, int>>& results) {
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::pair<std::string, int>> runResults = engine.execute(query);
+    auto end = std::chrono::steady_clock::now();
+    // moved out after the clock stops so freeing the previous run's results is not timed
+    results = std::move(runResults);
+    return std::chrono::duration<double, std::micro>(end - start).count();
+}
+
+double medianOf(std::vector<double> samples) {
+    std::sort(samples.begin(), samples.end());
+    size_t middle = samples.size() / 2;
+    return samples.size() % 2 ? samples[middle] : (samples[middle - 1] + samples[middle]) / 2;
+}
+
+// Indexes the folder with both backends and runs every query against each of them.
+// Each query is repeated benchmarkRuns times, alternating which backend goes first, and the median time is reported.
+void benchmarkEngines() {
+    using clock = std::chrono::steady_clock;
+    auto start = clock::now();
+    searchEngineUnordered unorderedEngine;
+    auto unorderedIndexed = clock::now();
+    searchEngineTries trieEngine;
+    auto trieIndexed = clock::now();
+    std::cout << "Indexing   Unordered Map: " << std::chrono::duration_cast<std::chrono::milliseconds>(unorderedIndexed - start).count() << " ms"
+              << "   Trie: " << std::chrono::duration_cast<std::chrono::milliseconds>(trieIndexed - unorderedIndexed).count() << " ms" << std::endl;
+    while(true){
+        std::string query;
+        std::cout << "Enter query: ";
+        if (!std::getline(std::cin, query) || query == "exit") break;
+        std::vector<std::pair<std::string, int>> unorderedResults, trieResults;
+        std::vector<double> unorderedTimes, trieTimes;
+        for (int run = 0; run < benchmarkRuns; run++) {
+            if (run % 2 == 0) {
+                unorderedTimes.push_back(timeQuery(unorderedEngine, query, unorderedResults));
+                trieTimes.push_back(timeQuery(trieEngine, query, trieResults));
+            } else {
+                trieTimes.push_back(timeQuery(trieEngine, query, trieResults));
+                unorderedTimes.push_back(timeQuery(unorderedEngine, query, unorderedResults));
+            }
+        }
+        std::cout << "Median of " << benchmarkRuns << " runs   Unordered Map: " << unorderedResults.size() << " results in " << medianOf(unorderedTimes) << " us"
+                  << "   Trie: " << trieResults.size() << " results in " << medianOf(trieTimes) << " us" << std::endl;
+        std::sort(unorderedResults.begin(), unorderedResults.end());
+        std::sort(trieResults.begin(), trieResults.end());
+        if (unorderedResults != trieResults) std::cout << "WARNING: Unordered Map and Trie returned different results for this query\n";
+    }
+}
+
+// Asks which folder to index and sets mainDir, returns false on an invalid choice
+bool chooseFolder() {
+    std::cout << "---------------------------------------------------" << std::endl;
+    std::cout << "Enter 'temp' to search in the temporary folder\n";
+    std::cout << "Enter 'review' to search in the review folder\n";
+    std::string choice;
+    if (!std::getline(std::cin, choice)) return false;
+    if (choice == "temp" || choice == "Temp") mainDir = mainDir2;
+    else if (choice == "review" || choice == "Review") mainDir = mainDir1;
+    else {
+        std::cout << "Invalid choice\n";
+        return false;
+    }
+    return true;
+}
+
 void wholeProject() {
     std::cout << "Welcome to the Search Engine\n";
     std::cout << "---------------------------------------------------" << std::endl;
     std::cout << "Enter 1 for Unordered Map Search Engine\n";
     std::cout << "Enter 2 for Trie Search Engine\n";
+    std::cout << "Enter 3 to benchmark both engines on the same queries\n";
     std::cout << "Enter 'exit' to exit the program\n";
     std::string choice;
-    std::getline(std::cin, choice);
+    if (!std::getline(std::cin, choice)) return;
     if (choice == "1") {
-        std::cout << "---------------------------------------------------" << std::endl;
-        std::cout << "Enter 'temp' to search in the temporary folder\n";
-        std::cout << "Enter 'review' to search in the review folder\n";
-        std::string choice;
-        std::getline(std::cin, choice);
-        if (choice == "temp" || choice == "Temp") mainDir = mainDir2;
-        else if (choice == "review" || choice == "Review") mainDir = mainDir1;
-        else {
-            std::cout << "Invalid choice\n";
-            wholeProject();
-        }
+        if (!chooseFolder()) { wholeProject(); return; }
         searchEngineUnordered searchEngine;
         searchEngine.engine();
     } else if (choice == "2") {
-        std::cout << "---------------------------------------------------" << std::endl;
-        std::cout << "Enter 'temp' to search in the temporary folder\n";
-        std::cout << "Enter 'review' to search in the review folder\n";
-        std::string choice;
-        std::getline(std::cin, choice);
-        if (choice == "temp" || choice == "Temp") mainDir = mainDir2;
-        else if (choice == "review" || choice == "Review") mainDir = mainDir1;
-        else {
-            std::cout << "Invalid choice\n";
-            wholeProject();
-        }
+        if (!chooseFolder()) { wholeProject(); return; }
         searchEngineTries searchEngine;
         searchEngine.engine();
+    } else if (choice == "3") {
+        if (!chooseFolder()) { wholeProject(); return; }
+        benchmarkEngines();
     } else if (choice == "exit") {
         std::cout << "Exiting the program\n";
     } else {